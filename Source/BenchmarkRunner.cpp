@@ -0,0 +1,258 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    // first frames of each path include shader/texture warm-up and are not measured
+    const int g_WarmupFrames = 5;
+
+    double Percentile(const std::vector<double>& sorted, double fraction)
+    {
+        if (sorted.empty()) return 0.0;
+        size_t index = (size_t)(fraction * (double)(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+BenchmarkRunner::BenchmarkRunner()
+    : m_skippedFrames(0),
+    m_drawCalls(0),
+    m_stateChanges(0)
+{
+}
+
+bool BenchmarkRunner::LoadSuite(const char* filename)
+{
+    std::ifstream file(filename);
+    if (!file) {
+        std::cerr << "[Benchmark] Could not open suite: " << filename << std::endl;
+        return false;
+    }
+
+    m_entries.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        SUITE_ENTRY entry;
+        if (fields >> entry.name >> entry.pathFile) {
+            m_entries.push_back(entry);
+        }
+    }
+
+    std::cout << "[Benchmark] Loaded " << m_entries.size() << " paths from " << filename << std::endl;
+    return !m_entries.empty();
+}
+
+const std::vector<BenchmarkRunner::SUITE_ENTRY>& BenchmarkRunner::GetEntries() const
+{
+    return m_entries;
+}
+
+void BenchmarkRunner::BeginPath(const std::string& name)
+{
+    m_currentPath = name;
+    m_skippedFrames = 0;
+    m_frameTimes.clear();
+    m_drawCalls = 0;
+    m_stateChanges = 0;
+}
+
+void BenchmarkRunner::AddFrame(double frameMs, int drawCalls, int stateChanges)
+{
+    if (m_skippedFrames < g_WarmupFrames) {
+        m_skippedFrames++;
+        return;
+    }
+    m_frameTimes.push_back(frameMs);
+    m_drawCalls += drawCalls;
+    m_stateChanges += stateChanges;
+}
+
+void BenchmarkRunner::EndPath()
+{
+    PATH_RESULT result;
+    result.name = m_currentPath;
+    result.frames = (int)m_frameTimes.size();
+
+    if (!m_frameTimes.empty()) {
+        std::vector<double> sorted = m_frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0.0;
+        for (double ms : sorted) total += ms;
+
+        result.meanMs = total / (double)sorted.size();
+        result.p50Ms = Percentile(sorted, 0.50);
+        result.p95Ms = Percentile(sorted, 0.95);
+        result.p99Ms = Percentile(sorted, 0.99);
+        result.maxMs = sorted.back();
+        result.drawCalls = m_drawCalls;
+        result.stateChanges = m_stateChanges;
+    }
+    else {
+        std::cerr << "[Benchmark] Path '" << m_currentPath << "' has no frames past warm-up" << std::endl;
+    }
+
+    m_results.push_back(result);
+}
+
+void BenchmarkRunner::PrintReport() const
+{
+    std::cout << "\n[Benchmark] Results\n"
+        << std::left << std::setw(16) << "path"
+        << std::right << std::setw(8) << "frames"
+        << std::setw(10) << "mean ms" << std::setw(10) << "p50 ms"
+        << std::setw(10) << "p95 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "max ms"
+        << std::setw(8) << "draws" << std::setw(8) << "states" << "\n";
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& r : m_results) {
+        const double frames = (r.frames > 0) ? (double)r.frames : 1.0;
+        std::cout << std::left << std::setw(16) << r.name
+            << std::right << std::setw(8) << r.frames
+            << std::setw(10) << r.meanMs << std::setw(10) << r.p50Ms
+            << std::setw(10) << r.p95Ms << std::setw(10) << r.p99Ms << std::setw(10) << r.maxMs
+            << std::setprecision(1)
+            << std::setw(8) << (double)r.drawCalls / frames
+            << std::setw(8) << (double)r.stateChanges / frames
+            << std::setprecision(3) << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6) << std::endl;
+}
+
+bool BenchmarkRunner::WriteResults(const char* filename) const
+{
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "[Benchmark] Could not open " << filename << " for writing" << std::endl;
+        return false;
+    }
+
+    // draw calls and state changes are totals over all measured frames; times
+    // are written with enough digits to read back as the same double
+    file << "# name frames mean_ms p50_ms p95_ms p99_ms max_ms total_draw_calls total_state_changes\n";
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const auto& r : m_results) {
+        file << r.name << " " << r.frames << " "
+            << r.meanMs << " " << r.p50Ms << " " << r.p95Ms << " " << r.p99Ms << " " << r.maxMs << " "
+            << r.drawCalls << " " << r.stateChanges << "\n";
+    }
+    file.close();
+    if (!file) {
+        std::cerr << "[Benchmark] Could not write " << filename << std::endl;
+        return false;
+    }
+
+    std::cout << "[Benchmark] Wrote results to " << filename << std::endl;
+    return true;
+}
+
+bool BenchmarkRunner::ReadResults(const char* filename, std::vector<PATH_RESULT>& results)
+{
+    std::ifstream file(filename);
+    if (!file) return false;
+
+    results.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        PATH_RESULT r;
+        if (fields >> r.name >> r.frames >> r.meanMs >> r.p50Ms >> r.p95Ms >> r.p99Ms >> r.maxMs
+            >> r.drawCalls >> r.stateChanges) {
+            // trailing text means a different format, e.g. older per-frame averages
+            fields >> std::ws;
+            if (!fields.eof()) continue;
+            results.push_back(r);
+        }
+    }
+    return true;
+}
+
+bool BenchmarkRunner::CompareToBaseline(const char* filename, float thresholdPercent, bool bAllowNewPaths) const
+{
+    std::vector<PATH_RESULT> baseline;
+    if (!ReadResults(filename, baseline)) {
+        std::cerr << "[Benchmark] Could not open baseline: " << filename << std::endl;
+        return false;
+    }
+    if (baseline.empty()) {
+        std::cerr << "[Benchmark] Baseline has no readable entries: " << filename << std::endl;
+        return false;
+    }
+
+    const double limit = 1.0 + thresholdPercent / 100.0;
+    bool bPassed = true;
+
+    for (const auto& r : m_results) {
+        auto base = std::find_if(baseline.begin(), baseline.end(),
+            [&r](const PATH_RESULT& b) { return b.name == r.name; });
+        if (base == baseline.end()) {
+            if (bAllowNewPaths) {
+                std::cout << "[Benchmark] " << r.name << ": no baseline entry, skipped" << std::endl;
+            }
+            else {
+                std::cout << "[Benchmark] " << r.name << ": no baseline entry, FAILED" << std::endl;
+                bPassed = false;
+            }
+            continue;
+        }
+
+        // without measured frames, or with a different path, there is nothing to compare
+        if (r.frames == 0) {
+            std::cout << "[Benchmark] " << r.name << ": no frames measured, FAILED" << std::endl;
+            bPassed = false;
+            continue;
+        }
+        if (r.frames != base->frames) {
+            std::cout << "[Benchmark] " << r.name << ": " << r.frames << " frames vs baseline "
+                << base->frames << " (path changed), FAILED" << std::endl;
+            bPassed = false;
+            continue;
+        }
+
+        // frame times are noisy, so they get the threshold; the replay is deterministic,
+        // so any increase in draw calls or state changes is a real change in the renderer
+        bool bRegressed = false;
+        if (r.meanMs > base->meanMs * limit) {
+            std::cout << "[Benchmark] " << r.name << ": mean " << r.meanMs << " ms vs baseline " << base->meanMs << " ms" << std::endl;
+            bRegressed = true;
+        }
+        if (r.p95Ms > base->p95Ms * limit) {
+            std::cout << "[Benchmark] " << r.name << ": p95 " << r.p95Ms << " ms vs baseline " << base->p95Ms << " ms" << std::endl;
+            bRegressed = true;
+        }
+        if (r.drawCalls > base->drawCalls) {
+            std::cout << "[Benchmark] " << r.name << ": " << r.drawCalls << " total draw calls vs baseline " << base->drawCalls << std::endl;
+            bRegressed = true;
+        }
+        if (r.stateChanges > base->stateChanges) {
+            std::cout << "[Benchmark] " << r.name << ": " << r.stateChanges << " total state changes vs baseline " << base->stateChanges << std::endl;
+            bRegressed = true;
+        }
+
+        std::cout << "[Benchmark] " << r.name << ": " << (bRegressed ? "REGRESSED" : "ok") << std::endl;
+        if (bRegressed) bPassed = false;
+    }
+
+    for (const auto& b : baseline) {
+        auto current = std::find_if(m_results.begin(), m_results.end(),
+            [&b](const PATH_RESULT& r) { return r.name == b.name; });
+        if (current == m_results.end()) {
+            std::cout << "[Benchmark] " << b.name << ": in baseline but not run, FAILED" << std::endl;
+            bPassed = false;
+        }
+    }
+
+    std::cout << "[Benchmark] Baseline comparison (threshold " << thresholdPercent << "%): "
+        << (bPassed ? "PASSED" : "FAILED") << std::endl;
+    return bPassed;
+}
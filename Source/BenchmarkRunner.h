@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// BenchmarkRunner.h
+// ============
+// run a suite of named camera paths, collect per-frame statistics and compare
+// them against a stored baseline
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class BenchmarkRunner
+{
+public:
+    // constructor
+    BenchmarkRunner();
+
+    // one line of the suite file: "<name> <path file>"
+    struct SUITE_ENTRY
+    {
+        std::string name{};
+        std::string pathFile{};
+    };
+
+    // summary of one benchmarked path
+    struct PATH_RESULT
+    {
+        std::string name{};
+        int frames = 0;
+        double meanMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        // totals over the measured frames; integers so a stored baseline
+        // compares exactly against an identical replay
+        long long drawCalls = 0;
+        long long stateChanges = 0;
+    };
+
+    bool LoadSuite(const char* filename);
+    const std::vector<SUITE_ENTRY>& GetEntries() const;
+
+    // collect frames for a single path
+    void BeginPath(const std::string& name);
+    void AddFrame(double frameMs, int drawCalls, int stateChanges);
+    void EndPath();
+
+    void PrintReport() const;
+    bool WriteResults(const char* filename) const;
+
+    // returns false if any path regressed by more than thresholdPercent, or
+    // has no baseline entry unless bAllowNewPaths is set
+    bool CompareToBaseline(const char* filename, float thresholdPercent, bool bAllowNewPaths) const;
+
+private:
+    std::vector<SUITE_ENTRY> m_entries;
+    std::vector<PATH_RESULT> m_results;
+
+    std::string m_currentPath;
+    int m_skippedFrames;
+    std::vector<double> m_frameTimes;
+    long long m_drawCalls;
+    long long m_stateChanges;
+
+    static bool ReadResults(const char* filename, std::vector<PATH_RESULT>& results);
+};
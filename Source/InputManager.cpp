@@ -0,0 +1,37 @@
+#include "InputManager.h"
+
+InputManager::InputManager()
+    : m_bFirstMouse(true),
+    m_lastMouseX(0.0),
+    m_lastMouseY(0.0)
+{
+}
+
+void InputManager::PollInput(GLFWwindow* window)
+{
+    m_state.bForward = (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS);
+    m_state.bBack = (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS);
+    m_state.bLeft = (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS);
+    m_state.bRight = (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS);
+    m_state.bUp = (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS);
+    m_state.bDown = (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS);
+
+    double xpos = 0.0, ypos = 0.0;
+    glfwGetCursorPos(window, &xpos, &ypos);
+
+    if (m_bFirstMouse) {
+        m_lastMouseX = xpos;
+        m_lastMouseY = ypos;
+        m_bFirstMouse = false;
+    }
+
+    m_state.mouseDeltaX = xpos - m_lastMouseX;
+    m_state.mouseDeltaY = m_lastMouseY - ypos;
+    m_lastMouseX = xpos;
+    m_lastMouseY = ypos;
+}
+
+const InputManager::INPUT_STATE& InputManager::GetState() const
+{
+    return m_state;
+}
@@ -0,0 +1,40 @@
+///////////////////////////////////////////////////////////////////////////////
+// InputManager.h
+// ============
+// sample keyboard and mouse state once per frame, independent of the
+// operating system's key-repeat events
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLFW/glfw3.h"
+
+class InputManager
+{
+public:
+    // constructor
+    InputManager();
+
+    // input held during the current frame
+    struct INPUT_STATE
+    {
+        bool bForward = false;  // W
+        bool bBack = false;     // S
+        bool bLeft = false;     // A
+        bool bRight = false;    // D
+        bool bUp = false;       // Q
+        bool bDown = false;     // E
+        double mouseDeltaX = 0.0;
+        double mouseDeltaY = 0.0; // positive when the mouse moves up
+    };
+
+    // read key and cursor state; call once per frame after glfwPollEvents()
+    void PollInput(GLFWwindow* window);
+    const INPUT_STATE& GetState() const;
+
+private:
+    INPUT_STATE m_state;
+    bool m_bFirstMouse;
+    double m_lastMouseX;
+    double m_lastMouseY;
+};
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// InputRecorder.h
+// ============
+// capture timestamped input and camera state to a file, and play recorded
+// camera paths back deterministically
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+class InputRecorder
+{
+public:
+    // constructor
+    InputRecorder();
+    // destructor
+    ~InputRecorder();
+
+    // camera state captured once per rendered frame
+    struct CAMERA_SAMPLE
+    {
+        double time = 0.0;
+        glm::vec3 position = glm::vec3(0.0f);
+        float yaw = 0.0f;
+        float pitch = 0.0f;
+        bool bUsePerspective = true;
+    };
+
+    // raw key event as delivered by GLFW
+    struct INPUT_EVENT
+    {
+        double time = 0.0;
+        int key = 0;
+        int action = 0;
+    };
+
+    // start capturing; nothing is written until EndRecording()
+    void BeginRecording(const char* filename, double startTime);
+    // write everything captured so far to the output file
+    bool EndRecording();
+    bool IsRecording() const;
+
+    void RecordKeyEvent(double time, int key, int action);
+    void RecordCameraSample(const CAMERA_SAMPLE& sample);
+
+private:
+    bool m_bRecording;
+    double m_startTime;
+    std::string m_filename;
+    std::vector<INPUT_EVENT> m_events;
+    std::vector<CAMERA_SAMPLE> m_samples;
+};
+
+class CameraPathPlayer
+{
+public:
+    // constructor
+    CameraPathPlayer();
+
+    // load a path written by InputRecorder
+    bool LoadPath(const char* filename);
+    void Rewind();
+    bool IsFinished() const;
+    int GetSampleCount() const;
+
+    // advance exactly one recorded frame, independent of wall-clock time;
+    // returns false once the path is exhausted
+    bool NextSample(InputRecorder::CAMERA_SAMPLE& sample);
+
+private:
+    std::vector<InputRecorder::CAMERA_SAMPLE> m_samples;
+    size_t m_nextSample;
+};
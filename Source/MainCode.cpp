@@ -1,5 +1,8 @@
 #include <iostream>
 #include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <string>
 #include <GL/glew.h>
 #include "GLFW/glfw3.h"
 #include <glm/glm.hpp>
@@ -8,8 +11,10 @@
 
 #include "SceneManager.h"
 #include "ViewManager.h"
-#include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "InputManager.h"
+#include "InputRecorder.h"
+#include "BenchmarkRunner.h"
 
 // Global variables for camera and movement
 glm::vec3 g_CameraPosition(0.0f, 2.0f, 10.0f);
@@ -21,22 +26,108 @@ float g_CameraPitch = 0.0f;
 float g_CameraSpeed = 2.5f;
 float g_MouseSensitivity = 0.1f;
 
-bool g_FirstMouse = true;
-double g_LastMouseX = 400.0;
-double g_LastMouseY = 300.0;
-
 bool g_bUsePerspective = true; // Toggled by pressing 'O'
 
+// Per-frame input sampling and motion integration
+InputManager g_InputManager;
+float g_FixedTickRate = 0.0f;         // simulation ticks per second, 0 = integrate with the frame delta
+const float g_MaxFixedTickRate = 1000.0f;
+const int g_MaxTicksPerFrame = 32;    // beyond this the simulation falls behind instead of freezing the frame
+const double g_MaxFrameDelta = 0.25;  // clamp for long stalls, in seconds
+double g_TickAccumulator = 0.0;
+glm::vec3 g_PrevTickPosition = g_CameraPosition;
+glm::vec3 g_TickPosition = g_CameraPosition;
+
+// Input recording / camera path replay
+InputRecorder g_InputRecorder;
+bool g_bReplayActive = false; // live input does not move the camera while a path plays
+
 // Forward declarations
 void UpdateCameraVectors();
 void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
-void MouseCallback(GLFWwindow* window, double xpos, double ypos);
 void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
 bool InitializeGLFW();
 bool InitializeGLEW();
+void UpdateCamera(const InputManager::INPUT_STATE& input, double deltaTime);
+bool ParseFloat(const char* text, float& value);
+void UpdateViewManager(ViewManager* pViewManager);
+void RenderFrame(SceneManager* pSceneManager);
+InputRecorder::CAMERA_SAMPLE CaptureCameraSample();
+void ApplyCameraSample(const InputRecorder::CAMERA_SAMPLE& sample);
+bool RunBenchmark(GLFWwindow* window, SceneManager* pSceneManager,
+    const char* suiteFile, const char* baselineFile, const char* resultsFile, float thresholdPercent,
+    bool bAllowNewPaths);
 
 int main(int argc, char* argv[])
 {
+    // Command line:
+    //   --record <file>       capture input and camera state for this session
+    //   --replay <file>       play a recorded camera path back, then exit
+    //   --benchmark <suite>   run every path in the suite and report frame statistics
+    //   --baseline <file>     compare benchmark results against a stored baseline
+    //   --results <file>      write benchmark results (usable as a future baseline)
+    //   --threshold <pct>     allowed frame-time regression, default 10%
+    //   --allow-new-paths     suite paths missing from the baseline do not fail the gate
+    //   --fixed-tick <hz>     simulate camera motion at a fixed rate and interpolate
+    //   --texture-budget <mb> GPU memory budget for scene textures, default unlimited
+    const char* recordFile = nullptr;
+    const char* replayFile = nullptr;
+    const char* suiteFile = nullptr;
+    const char* baselineFile = nullptr;
+    const char* resultsFile = nullptr;
+    float thresholdPercent = 10.0f;
+    bool bAllowNewPaths = false;
+    size_t textureBudgetMB = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool bHasValue = (i + 1 < argc);
+        if (arg == "--record" && bHasValue)          recordFile = argv[++i];
+        else if (arg == "--replay" && bHasValue)     replayFile = argv[++i];
+        else if (arg == "--benchmark" && bHasValue)  suiteFile = argv[++i];
+        else if (arg == "--baseline" && bHasValue)   baselineFile = argv[++i];
+        else if (arg == "--results" && bHasValue)    resultsFile = argv[++i];
+        else if (arg == "--allow-new-paths")         bAllowNewPaths = true;
+        else if (arg == "--threshold" && bHasValue)
+        {
+            // percent, 0 allows no regression at all
+            float threshold = 0.0f;
+            if (!ParseFloat(argv[++i], threshold) || !(threshold >= 0.0f && threshold <= 1000.0f))
+            {
+                std::cerr << "Invalid threshold: " << argv[i] << std::endl;
+                return(EXIT_FAILURE);
+            }
+            thresholdPercent = threshold;
+        }
+        else if (arg == "--fixed-tick" && bHasValue)
+        {
+            float rate = 0.0f;
+            if (!ParseFloat(argv[++i], rate) || !(rate > 0.0f && rate <= g_MaxFixedTickRate))
+            {
+                std::cerr << "Invalid fixed tick rate (0 < hz <= " << g_MaxFixedTickRate << "): " << argv[i] << std::endl;
+                return(EXIT_FAILURE);
+            }
+            g_FixedTickRate = rate;
+        }
+        else if (arg == "--texture-budget" && bHasValue)
+        {
+            // positive MB that still fits in size_t once converted to bytes
+            long budget = atol(argv[++i]);
+            if (budget <= 0 || (unsigned long)budget > SIZE_MAX / (1024 * 1024))
+            {
+                std::cerr << "Invalid texture budget: " << argv[i] << std::endl;
+                return(EXIT_FAILURE);
+            }
+            textureBudgetMB = (size_t)budget;
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+            return(EXIT_FAILURE);
+        }
+    }
+
     if (!InitializeGLFW())
         return(EXIT_FAILURE);
 
@@ -46,7 +137,6 @@ int main(int argc, char* argv[])
 
     glfwSetInputMode(g_Window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetKeyCallback(g_Window, KeyCallback);
-    glfwSetCursorPosCallback(g_Window, MouseCallback);
     glfwSetScrollCallback(g_Window, ScrollCallback);
 
     if (!InitializeGLEW())
@@ -58,41 +148,188 @@ int main(int argc, char* argv[])
     g_ShaderManager->use();
 
     SceneManager* g_SceneManager = new SceneManager(g_ShaderManager);
+    if (textureBudgetMB > 0)
+        g_SceneManager->SetTextureBudget(textureBudgetMB * 1024 * 1024);
     g_SceneManager->PrepareScene();
     std::cout << "[Main] Scene prepared." << std::endl;
 
-    while (!glfwWindowShouldClose(g_Window))
+    int exitCode = EXIT_SUCCESS;
+
+    if (suiteFile)
     {
-        glEnable(GL_DEPTH_TEST);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        g_bReplayActive = true;
+        if (!RunBenchmark(g_Window, g_SceneManager,
+            suiteFile, baselineFile, resultsFile, thresholdPercent, bAllowNewPaths))
+            exitCode = EXIT_FAILURE;
+    }
+    else
+    {
+        CameraPathPlayer player;
+        if (replayFile)
+        {
+            if (!player.LoadPath(replayFile))
+                return(EXIT_FAILURE);
+            g_bReplayActive = true;
+        }
+        if (recordFile)
+            g_InputRecorder.BeginRecording(recordFile, glfwGetTime());
+
+        double lastFrameTime = glfwGetTime();
+        while (!glfwWindowShouldClose(g_Window))
+        {
+            // Sample input and move the camera as late as possible, right
+            // before the view matrix is built for this frame.
+            glfwPollEvents();
+
+            double now = glfwGetTime();
+            double deltaTime = now - lastFrameTime;
+            lastFrameTime = now;
+
+            if (g_bReplayActive)
+            {
+                InputRecorder::CAMERA_SAMPLE sample;
+                if (!player.NextSample(sample))
+                    break;
+                ApplyCameraSample(sample);
+            }
+            else
+            {
+                g_InputManager.PollInput(g_Window);
+                UpdateCamera(g_InputManager.GetState(), deltaTime);
+            }
+
+            if (g_InputRecorder.IsRecording())
+                g_InputRecorder.RecordCameraSample(CaptureCameraSample());
+
+            UpdateViewManager(g_ViewManager);
+            RenderFrame(g_SceneManager);
+
+            glfwSwapBuffers(g_Window);
+
+            // Print camera position for debugging
+            std::cout << "[Debug] Camera Position: "
+                << g_CameraPosition.x << ", "
+                << g_CameraPosition.y << ", "
+                << g_CameraPosition.z << std::endl;
+        }
 
-        glm::mat4 view = glm::lookAt(g_CameraPosition, g_CameraPosition + g_CameraFront, g_CameraUp);
-        g_ViewManager->SetViewMatrix(view);
+        if (g_InputRecorder.IsRecording())
+            g_InputRecorder.EndRecording();
+    }
 
-        if (g_bUsePerspective)
-            g_ViewManager->SetPerspectiveMode();
-        else
-            g_ViewManager->SetOrthographicMode();
+    if (g_SceneManager) { delete g_SceneManager; g_SceneManager = nullptr; }
+    if (g_ViewManager) { delete g_ViewManager;  g_ViewManager = nullptr; }
+    if (g_ShaderManager) { delete g_ShaderManager; g_ShaderManager = nullptr; }
+
+    exit(exitCode);
+}
+
+// Keep the ViewManager in step with the camera for the interactive loop.
+// Every call logs to the console, and RenderScene sets the view and
+// projection uniforms itself, so the benchmark skips this.
+void UpdateViewManager(ViewManager* pViewManager)
+{
+    glm::mat4 view = glm::lookAt(g_CameraPosition, g_CameraPosition + g_CameraFront, g_CameraUp);
+    pViewManager->SetViewMatrix(view);
+
+    if (g_bUsePerspective)
+        pViewManager->SetPerspectiveMode();
+    else
+        pViewManager->SetOrthographicMode();
+
+    pViewManager->PrepareSceneView();
+}
+
+void RenderFrame(SceneManager* pSceneManager)
+{
+    glEnable(GL_DEPTH_TEST);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    pSceneManager->RenderScene();
+}
+
+InputRecorder::CAMERA_SAMPLE CaptureCameraSample()
+{
+    InputRecorder::CAMERA_SAMPLE sample;
+    sample.time = glfwGetTime();
+    sample.position = g_CameraPosition;
+    sample.yaw = g_CameraYaw;
+    sample.pitch = g_CameraPitch;
+    sample.bUsePerspective = g_bUsePerspective;
+    return sample;
+}
+
+void ApplyCameraSample(const InputRecorder::CAMERA_SAMPLE& sample)
+{
+    g_CameraPosition = sample.position;
+    g_CameraYaw = sample.yaw;
+    g_CameraPitch = sample.pitch;
+    g_bUsePerspective = sample.bUsePerspective;
+    UpdateCameraVectors();
+}
+
+bool RunBenchmark(GLFWwindow* window, SceneManager* pSceneManager,
+    const char* suiteFile, const char* baselineFile, const char* resultsFile, float thresholdPercent,
+    bool bAllowNewPaths)
+{
+    BenchmarkRunner runner;
+    if (!runner.LoadSuite(suiteFile))
+        return false;
+
+    // measure raw frame cost rather than the display refresh rate
+    glfwSwapInterval(0);
+
+    for (const auto& entry : runner.GetEntries())
+    {
+        CameraPathPlayer player;
+        if (!player.LoadPath(entry.pathFile.c_str()))
+            return false;
+
+        std::cout << "[Benchmark] Running '" << entry.name << "' (" << player.GetSampleCount() << " frames)" << std::endl;
+        runner.BeginPath(entry.name);
+
+        InputRecorder::CAMERA_SAMPLE sample;
+        double lastTime = glfwGetTime();
+        while (!glfwWindowShouldClose(window) && player.NextSample(sample))
+        {
+            ApplyCameraSample(sample);
 
-        g_ViewManager->PrepareSceneView();
+            pSceneManager->ResetRenderStats();
+            // no per-frame console output here; it would be measured as frame time
+            RenderFrame(pSceneManager);
 
-        g_SceneManager->RenderScene();
+            glfwSwapBuffers(window);
+            glFinish(); // include GPU time in the measurement
+            glfwPollEvents();
 
-        glfwSwapBuffers(g_Window);
-        glfwPollEvents();
+            double now = glfwGetTime();
+            const RENDER_STATS& stats = pSceneManager->GetRenderStats();
+            runner.AddFrame((now - lastTime) * 1000.0, stats.drawCalls, stats.stateChanges);
+            lastTime = now;
+        }
+
+        runner.EndPath();
 
-        // Print camera position for debugging
-        std::cout << "[Debug] Camera Position: "
-            << g_CameraPosition.x << ", "
-            << g_CameraPosition.y << ", "
-            << g_CameraPosition.z << std::endl;
+        // an interrupted path would compare as "faster than baseline"
+        if (!player.IsFinished())
+        {
+            std::cerr << "[Benchmark] Window closed during '" << entry.name << "'; run aborted" << std::endl;
+            return false;
+        }
     }
 
-    if (g_SceneManager) { delete g_SceneManager; g_SceneManager = nullptr; }
-    if (g_ViewManager) { delete g_ViewManager;  g_ViewManager = nullptr; }
-    if (g_ShaderManager) { delete g_ShaderManager; g_ShaderManager = nullptr; }
+    runner.PrintReport();
+
+    // a requested results file that could not be written fails the run, even if the
+    // baseline comparison still runs and reports
+    bool bPassed = true;
+    if (resultsFile && !runner.WriteResults(resultsFile))
+        bPassed = false;
+
+    if (baselineFile && !runner.CompareToBaseline(baselineFile, thresholdPercent, bAllowNewPaths))
+        bPassed = false;
 
-    exit(EXIT_SUCCESS);
+    return bPassed;
 }
 
 void UpdateCameraVectors()
@@ -106,66 +343,96 @@ void UpdateCameraVectors()
 
 void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
+    g_InputRecorder.RecordKeyEvent(glfwGetTime(), key, action);
+
     if (action == GLFW_PRESS)
         std::cout << "[Input] Key pressed: " << key << std::endl;
 
-    float deltaTime = 1.0f / 60.0f;
-    float velocity = g_CameraSpeed * deltaTime;
-
     if ((key == GLFW_KEY_ESCAPE) && action == GLFW_PRESS)
     {
         glfwSetWindowShouldClose(window, true);
     }
 
-    if (action == GLFW_PRESS || action == GLFW_REPEAT)
+    if (g_bReplayActive)
+        return;
+
+    // Movement keys are polled once per frame by InputManager; only
+    // one-shot toggles are handled as events here.
+    if (key == GLFW_KEY_O && action == GLFW_PRESS)
     {
-        if (key == GLFW_KEY_W)
-            g_CameraPosition += g_CameraFront * velocity;
-        else if (key == GLFW_KEY_S)
-            g_CameraPosition -= g_CameraFront * velocity;
-        else if (key == GLFW_KEY_A)
-            g_CameraPosition -= glm::normalize(glm::cross(g_CameraFront, g_CameraUp)) * velocity;
-        else if (key == GLFW_KEY_D)
-            g_CameraPosition += glm::normalize(glm::cross(g_CameraFront, g_CameraUp)) * velocity;
-        else if (key == GLFW_KEY_Q)
-            g_CameraPosition.y += velocity;
-        else if (key == GLFW_KEY_E)
-            g_CameraPosition.y -= velocity;
-        else if (key == GLFW_KEY_O && action == GLFW_PRESS)
-        {
-            g_bUsePerspective = !g_bUsePerspective;
-            std::cout << "[Camera] Projection mode toggled: "
-                << (g_bUsePerspective ? "Perspective" : "Orthographic") << std::endl;
-        }
+        g_bUsePerspective = !g_bUsePerspective;
+        std::cout << "[Camera] Projection mode toggled: "
+            << (g_bUsePerspective ? "Perspective" : "Orthographic") << std::endl;
     }
     // Note: We do NOT reset the camera position anywhere here.
 }
 
-void MouseCallback(GLFWwindow* window, double xpos, double ypos)
+void UpdateCamera(const InputManager::INPUT_STATE& input, double deltaTime)
 {
-    if (g_FirstMouse)
-    {
-        g_LastMouseX = xpos;
-        g_LastMouseY = ypos;
-        g_FirstMouse = false;
-    }
-
-    double xoffset = xpos - g_LastMouseX;
-    double yoffset = g_LastMouseY - ypos;
-    g_LastMouseX = xpos;
-    g_LastMouseY = ypos;
-
-    xoffset *= g_MouseSensitivity;
-    yoffset *= g_MouseSensitivity;
-
-    g_CameraYaw += (float)xoffset;
-    g_CameraPitch += (float)yoffset;
+    // Mouse look is applied every frame, never interpolated, so rotation
+    // always reflects the newest cursor sample.
+    g_CameraYaw += (float)(input.mouseDeltaX * g_MouseSensitivity);
+    g_CameraPitch += (float)(input.mouseDeltaY * g_MouseSensitivity);
 
     if (g_CameraPitch > 89.0f)  g_CameraPitch = 89.0f;
     if (g_CameraPitch < -89.0f) g_CameraPitch = -89.0f;
 
     UpdateCameraVectors();
-    std::cout << "[Input] Mouse moved to: (" << xpos << ", " << ypos << ")" << std::endl;
+
+    // Movement direction from the keys held this frame
+    glm::vec3 right = glm::normalize(glm::cross(g_CameraFront, g_CameraUp));
+    glm::vec3 direction(0.0f);
+    if (input.bForward) direction += g_CameraFront;
+    if (input.bBack)    direction -= g_CameraFront;
+    if (input.bRight)   direction += right;
+    if (input.bLeft)    direction -= right;
+    if (input.bUp)      direction.y += 1.0f;
+    if (input.bDown)    direction.y -= 1.0f;
+    if (glm::length(direction) > 0.0f)
+        direction = glm::normalize(direction);
+
+    // Avoid a huge jump after a stall (window drag, breakpoint)
+    if (deltaTime > g_MaxFrameDelta)
+        deltaTime = g_MaxFrameDelta;
+
+    if (g_FixedTickRate <= 0.0f)
+    {
+        g_CameraPosition += direction * (g_CameraSpeed * (float)deltaTime);
+        return;
+    }
+
+    // Fixed-tick simulation: step in whole ticks and interpolate the
+    // rendered position between the last two simulated states.
+    const double tick = 1.0 / g_FixedTickRate;
+    g_TickAccumulator += deltaTime;
+    int ticks = 0;
+    while (g_TickAccumulator >= tick)
+    {
+        if (ticks == g_MaxTicksPerFrame)
+        {
+            // too far behind to catch up; drop the backlog, keep the fraction
+            g_TickAccumulator = fmod(g_TickAccumulator, tick);
+            break;
+        }
+        g_PrevTickPosition = g_TickPosition;
+        g_TickPosition += direction * (g_CameraSpeed * (float)tick);
+        g_TickAccumulator -= tick;
+        ticks++;
+    }
+
+    float alpha = (float)(g_TickAccumulator / tick);
+    g_CameraPosition = glm::mix(g_PrevTickPosition, g_TickPosition, alpha);
+}
+
+// whole argument must be a finite number; atof would turn garbage into 0
+bool ParseFloat(const char* text, float& value)
+{
+    char* end = nullptr;
+    double parsed = strtod(text, &end);
+    if (end == text || *end != '\0' || !std::isfinite(parsed))
+        return false;
+    value = (float)parsed;
+    return true;
 }
 
 void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
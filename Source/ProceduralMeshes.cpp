@@ -0,0 +1,456 @@
+#include "ProceduralMeshes.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <process.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const float g_Pi = 3.14159265358979f;
+
+    // bump whenever the generators change so stale cache files are regenerated
+    const uint32_t g_CacheVersion = 1;
+    const char g_CacheMagic[4] = { 'P', 'M', 'S', 'H' };
+    const char* g_CacheFilePrefix = "mesh_cache_";
+
+    const int g_FloatsPerVertex = 8;
+    const int g_DefaultRoundSlices = 36;
+    const int g_DefaultSphereStacks = 18;
+
+    void AddVertex(ProceduralMeshes::MESH_DATA& mesh,
+        float x, float y, float z, float nx, float ny, float nz, float u, float v)
+    {
+        const float vertex[g_FloatsPerVertex] = { x, y, z, nx, ny, nz, u, v };
+        mesh.vertices.insert(mesh.vertices.end(), vertex, vertex + g_FloatsPerVertex);
+    }
+
+    GLuint VertexCount(const ProceduralMeshes::MESH_DATA& mesh)
+    {
+        return (GLuint)(mesh.vertices.size() / g_FloatsPerVertex);
+    }
+
+    void AddQuad(ProceduralMeshes::MESH_DATA& mesh, GLuint a, GLuint b, GLuint c, GLuint d)
+    {
+        const GLuint quad[6] = { a, b, c, a, c, d };
+        mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+    }
+
+    // flat disc at height y facing up (ny = 1) or down (ny = -1)
+    void AddCap(ProceduralMeshes::MESH_DATA& mesh, int slices, float y, float ny)
+    {
+        GLuint center = VertexCount(mesh);
+        AddVertex(mesh, 0.0f, y, 0.0f, 0.0f, ny, 0.0f, 0.5f, 0.5f);
+        for (int i = 0; i <= slices; i++) {
+            float angle = 2.0f * g_Pi * (float)i / (float)slices;
+            float x = cosf(angle), z = sinf(angle);
+            AddVertex(mesh, x, y, z, 0.0f, ny, 0.0f, 0.5f + 0.5f * x, 0.5f + 0.5f * z);
+        }
+        for (int i = 0; i < slices; i++) {
+            GLuint ring = center + 1 + i;
+            if (ny > 0.0f) {
+                const GLuint tri[3] = { center, ring + 1, ring };
+                mesh.indices.insert(mesh.indices.end(), tri, tri + 3);
+            }
+            else {
+                const GLuint tri[3] = { center, ring, ring + 1 };
+                mesh.indices.insert(mesh.indices.end(), tri, tri + 3);
+            }
+        }
+    }
+
+    void GeneratePlane(ProceduralMeshes::MESH_DATA& mesh)
+    {
+        AddVertex(mesh, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+        AddVertex(mesh, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f);
+        AddVertex(mesh, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f);
+        AddVertex(mesh, -1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f);
+        AddQuad(mesh, 0, 1, 2, 3);
+    }
+
+    void GenerateBox(ProceduralMeshes::MESH_DATA& mesh)
+    {
+        // one face per axis direction: normal, then the two in-plane axes
+        const float faces[6][9] = {
+            {  0.0f,  0.0f,  1.0f,   1.0f, 0.0f,  0.0f,   0.0f, 1.0f,  0.0f },
+            {  0.0f,  0.0f, -1.0f,  -1.0f, 0.0f,  0.0f,   0.0f, 1.0f,  0.0f },
+            {  1.0f,  0.0f,  0.0f,   0.0f, 0.0f, -1.0f,   0.0f, 1.0f,  0.0f },
+            { -1.0f,  0.0f,  0.0f,   0.0f, 0.0f,  1.0f,   0.0f, 1.0f,  0.0f },
+            {  0.0f,  1.0f,  0.0f,   1.0f, 0.0f,  0.0f,   0.0f, 0.0f, -1.0f },
+            {  0.0f, -1.0f,  0.0f,   1.0f, 0.0f,  0.0f,   0.0f, 0.0f,  1.0f },
+        };
+        const float corners[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+
+        for (const auto& f : faces) {
+            GLuint first = VertexCount(mesh);
+            for (const auto& c : corners) {
+                float x = 0.5f * f[0] + c[0] * f[3] + c[1] * f[6];
+                float y = 0.5f * f[1] + c[0] * f[4] + c[1] * f[7];
+                float z = 0.5f * f[2] + c[0] * f[5] + c[1] * f[8];
+                AddVertex(mesh, x, y, z, f[0], f[1], f[2], c[0] + 0.5f, c[1] + 0.5f);
+            }
+            AddQuad(mesh, first, first + 1, first + 2, first + 3);
+        }
+    }
+
+    void GenerateCylinder(ProceduralMeshes::MESH_DATA& mesh, int slices)
+    {
+        GLuint first = VertexCount(mesh);
+        for (int i = 0; i <= slices; i++) {
+            float u = (float)i / (float)slices;
+            float angle = 2.0f * g_Pi * u;
+            float x = cosf(angle), z = sinf(angle);
+            AddVertex(mesh, x, 0.0f, z, x, 0.0f, z, u, 0.0f);
+            AddVertex(mesh, x, 1.0f, z, x, 0.0f, z, u, 1.0f);
+        }
+        for (int i = 0; i < slices; i++) {
+            GLuint bottom = first + 2 * i;
+            AddQuad(mesh, bottom, bottom + 1, bottom + 3, bottom + 2);
+        }
+
+        AddCap(mesh, slices, 0.0f, -1.0f);
+        AddCap(mesh, slices, 1.0f, 1.0f);
+    }
+
+    void GenerateCone(ProceduralMeshes::MESH_DATA& mesh, int slices)
+    {
+        // slope normal of a radius 1, height 1 cone
+        const float normalScale = 1.0f / sqrtf(2.0f);
+
+        GLuint first = VertexCount(mesh);
+        for (int i = 0; i <= slices; i++) {
+            float u = (float)i / (float)slices;
+            float angle = 2.0f * g_Pi * u;
+            float x = cosf(angle), z = sinf(angle);
+            AddVertex(mesh, x, 0.0f, z, x * normalScale, normalScale, z * normalScale, u, 0.0f);
+
+            // one apex per slice so each side keeps its own normal and UV
+            float mid = 2.0f * g_Pi * ((float)i + 0.5f) / (float)slices;
+            AddVertex(mesh, 0.0f, 1.0f, 0.0f, cosf(mid) * normalScale, normalScale, sinf(mid) * normalScale, u, 1.0f);
+        }
+        for (int i = 0; i < slices; i++) {
+            GLuint base = first + 2 * i;
+            const GLuint tri[3] = { base, base + 1, base + 2 };
+            mesh.indices.insert(mesh.indices.end(), tri, tri + 3);
+        }
+
+        AddCap(mesh, slices, 0.0f, -1.0f);
+    }
+
+    void GenerateSphere(ProceduralMeshes::MESH_DATA& mesh, int slices, int stacks)
+    {
+        for (int stack = 0; stack <= stacks; stack++) {
+            float v = (float)stack / (float)stacks;
+            float phi = g_Pi * v;
+            float y = cosf(phi), ring = sinf(phi);
+            for (int slice = 0; slice <= slices; slice++) {
+                float u = (float)slice / (float)slices;
+                float theta = 2.0f * g_Pi * u;
+                float x = ring * cosf(theta), z = ring * sinf(theta);
+                AddVertex(mesh, x, y, z, x, y, z, u, 1.0f - v);
+            }
+        }
+        for (int stack = 0; stack < stacks; stack++) {
+            for (int slice = 0; slice < slices; slice++) {
+                GLuint a = stack * (slices + 1) + slice;
+                GLuint b = a + slices + 1;
+                AddQuad(mesh, a, a + 1, b + 1, b);
+            }
+        }
+    }
+
+    // any failure, including a corrupt or truncated file, is reported as a cache miss
+    bool ReadCache(const std::string& filename, ProceduralMeshes::MESH_DATA& mesh)
+    {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        const uint64_t fileSize = (uint64_t)file.tellg();
+        file.seekg(0);
+
+        char magic[4] = {};
+        uint32_t version = 0, vertexFloats = 0, indexCount = 0;
+        file.read(magic, sizeof(magic));
+        file.read((char*)&version, sizeof(version));
+        file.read((char*)&vertexFloats, sizeof(vertexFloats));
+        file.read((char*)&indexCount, sizeof(indexCount));
+        if (!file || memcmp(magic, g_CacheMagic, sizeof(magic)) != 0 || version != g_CacheVersion) {
+            return false;
+        }
+
+        // header counts must describe whole vertices and triangles and match
+        // the file size exactly before anything is allocated from them
+        const uint64_t headerSize = sizeof(magic) + 3 * sizeof(uint32_t);
+        const uint64_t expectedSize = headerSize
+            + (uint64_t)vertexFloats * sizeof(float) + (uint64_t)indexCount * sizeof(GLuint);
+        if (vertexFloats == 0 || vertexFloats % g_FloatsPerVertex != 0 ||
+            indexCount == 0 || indexCount % 3 != 0 || expectedSize != fileSize) {
+            return false;
+        }
+
+        mesh.vertices.resize(vertexFloats);
+        mesh.indices.resize(indexCount);
+        file.read((char*)mesh.vertices.data(), (std::streamsize)vertexFloats * sizeof(float));
+        file.read((char*)mesh.indices.data(), (std::streamsize)indexCount * sizeof(GLuint));
+        if (!file) return false;
+
+        const GLuint vertexCount = vertexFloats / g_FloatsPerVertex;
+        for (GLuint index : mesh.indices) {
+            if (index >= vertexCount) return false;
+        }
+        return true;
+    }
+
+    unsigned long CurrentProcessId()
+    {
+#ifdef _WIN32
+        return (unsigned long)_getpid();
+#else
+        return (unsigned long)getpid();
+#endif
+    }
+
+    // atomically replace target with source; an existing target stays readable until then
+    bool MoveIntoPlace(const std::string& source, const std::string& target)
+    {
+#ifdef _WIN32
+        return MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return std::rename(source.c_str(), target.c_str()) == 0;
+#endif
+    }
+
+    void WriteCache(const std::string& filename, const ProceduralMeshes::MESH_DATA& mesh)
+    {
+        // write to a name unique to this process and worker thread, then move it into
+        // place in one step so readers only ever see a missing or a complete file
+        std::ostringstream temp;
+        temp << filename << "." << CurrentProcessId() << "."
+            << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+        const std::string tempName = temp.str();
+        {
+            std::ofstream file(tempName, std::ios::binary | std::ios::trunc);
+            if (!file) return;
+
+            uint32_t vertexFloats = (uint32_t)mesh.vertices.size();
+            uint32_t indexCount = (uint32_t)mesh.indices.size();
+            file.write(g_CacheMagic, sizeof(g_CacheMagic));
+            file.write((const char*)&g_CacheVersion, sizeof(g_CacheVersion));
+            file.write((const char*)&vertexFloats, sizeof(vertexFloats));
+            file.write((const char*)&indexCount, sizeof(indexCount));
+            file.write((const char*)mesh.vertices.data(), vertexFloats * sizeof(float));
+            file.write((const char*)mesh.indices.data(), indexCount * sizeof(GLuint));
+            if (!file) {
+                file.close();
+                std::remove(tempName.c_str());
+                return;
+            }
+        }
+        if (!MoveIntoPlace(tempName, filename)) {
+            std::remove(tempName.c_str());
+        }
+    }
+}
+
+ProceduralMeshes::ProceduralMeshes()
+    : m_pRenderStats(nullptr)
+{
+}
+
+ProceduralMeshes::~ProceduralMeshes()
+{
+    // let outstanding jobs finish before their results are discarded
+    for (auto& job : m_pending) {
+        job.second.wait();
+    }
+    m_pending.clear();
+
+    for (auto& entry : m_meshes) {
+        glDeleteVertexArrays(1, &entry.second.vao);
+        glDeleteBuffers(1, &entry.second.vbo);
+        glDeleteBuffers(1, &entry.second.ebo);
+    }
+    m_meshes.clear();
+}
+
+ProceduralMeshes::MESH_KEY ProceduralMeshes::ResolveKey(MESH_TYPE type, int slices, int stacks)
+{
+    MESH_KEY key;
+    key.type = type;
+    switch (type) {
+    case MESH_CYLINDER:
+    case MESH_CONE:
+        key.slices = (slices > 2) ? slices : g_DefaultRoundSlices;
+        break;
+    case MESH_SPHERE:
+        key.slices = (slices > 2) ? slices : g_DefaultRoundSlices;
+        key.stacks = (stacks > 1) ? stacks : g_DefaultSphereStacks;
+        break;
+    default:
+        // plane and box have no tessellation parameters
+        break;
+    }
+    return key;
+}
+
+std::string ProceduralMeshes::KeyName(const MESH_KEY& key)
+{
+    static const char* typeNames[] = { "plane", "box", "cylinder", "cone", "sphere" };
+    std::ostringstream name;
+    name << typeNames[key.type];
+    if (key.slices > 0) name << "_" << key.slices;
+    if (key.stacks > 0) name << "x" << key.stacks;
+    return name.str();
+}
+
+ProceduralMeshes::MESH_DATA ProceduralMeshes::BuildMesh(MESH_KEY key)
+{
+    // runs on a worker thread: no GL calls and no shared state
+    MESH_DATA mesh;
+    std::string cacheFile = std::string(g_CacheFilePrefix) + KeyName(key) + ".bin";
+    bool bCacheHit = false;
+    try {
+        bCacheHit = ReadCache(cacheFile, mesh);
+    }
+    catch (const std::exception&) {
+        bCacheHit = false;
+    }
+    if (bCacheHit) {
+        mesh.key = key;
+        mesh.bFromCache = true;
+        return mesh;
+    }
+
+    mesh = MESH_DATA();
+    mesh.key = key;
+    switch (key.type) {
+    case MESH_PLANE:    GeneratePlane(mesh); break;
+    case MESH_BOX:      GenerateBox(mesh); break;
+    case MESH_CYLINDER: GenerateCylinder(mesh, key.slices); break;
+    case MESH_CONE:     GenerateCone(mesh, key.slices); break;
+    case MESH_SPHERE:   GenerateSphere(mesh, key.slices, key.stacks); break;
+    }
+
+    WriteCache(cacheFile, mesh);
+    return mesh;
+}
+
+void ProceduralMeshes::RequestMesh(MESH_TYPE type, int slices, int stacks)
+{
+    MESH_KEY key = ResolveKey(type, slices, stacks);
+    if (m_meshes.count(key) || m_pending.count(key)) {
+        return;
+    }
+    m_pending[key] = std::async(std::launch::async, &ProceduralMeshes::BuildMesh, key);
+}
+
+void ProceduralMeshes::UploadPendingMeshes()
+{
+    for (auto& job : m_pending) {
+        MESH_DATA mesh;
+        try {
+            mesh = job.second.get();
+        }
+        catch (const std::exception& e) {
+            // leave the mesh out; DrawMesh skips meshes that were never uploaded
+            std::cerr << "[ProceduralMeshes] Mesh generation failed: " << e.what() << std::endl;
+            continue;
+        }
+
+        GL_MESH glMesh;
+        glMesh.key = mesh.key;
+        glMesh.indexCount = (GLsizei)mesh.indices.size();
+
+        glGenVertexArrays(1, &glMesh.vao);
+        glBindVertexArray(glMesh.vao);
+
+        glGenBuffers(1, &glMesh.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, glMesh.vbo);
+        glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), mesh.vertices.data(), GL_STATIC_DRAW);
+
+        glGenBuffers(1, &glMesh.ebo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glMesh.ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(GLuint), mesh.indices.data(), GL_STATIC_DRAW);
+
+        const GLsizei stride = g_FloatsPerVertex * sizeof(float);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+
+        glBindVertexArray(0);
+
+        m_meshes[job.first] = glMesh;
+        std::cout << "[ProceduralMeshes] " << KeyName(glMesh.key) << ": "
+            << (mesh.bFromCache ? "loaded from cache" : "generated") << " ("
+            << mesh.vertices.size() / g_FloatsPerVertex << " vertices, "
+            << mesh.indices.size() << " indices)" << std::endl;
+    }
+    m_pending.clear();
+}
+
+void ProceduralMeshes::SetRenderStats(RENDER_STATS* pRenderStats)
+{
+    m_pRenderStats = pRenderStats;
+}
+
+void ProceduralMeshes::DrawMesh(MESH_TYPE type, int slices, int stacks)
+{
+    auto entry = m_meshes.find(ResolveKey(type, slices, stacks));
+    if (entry == m_meshes.end()) {
+        return;
+    }
+    glBindVertexArray(entry->second.vao);
+    glDrawElements(GL_TRIANGLES, entry->second.indexCount, GL_UNSIGNED_INT, (void*)0);
+    glBindVertexArray(0);
+
+    if (m_pRenderStats) {
+        m_pRenderStats->drawCalls++;
+        m_pRenderStats->stateChanges += 2; // bind and unbind of the VAO above
+    }
+}
+
+void ProceduralMeshes::DrawPlaneMesh()
+{
+    DrawMesh(MESH_PLANE);
+}
+
+void ProceduralMeshes::DrawBoxMesh()
+{
+    DrawMesh(MESH_BOX);
+}
+
+void ProceduralMeshes::DrawCylinderMesh()
+{
+    DrawMesh(MESH_CYLINDER);
+}
+
+void ProceduralMeshes::DrawConeMesh()
+{
+    DrawMesh(MESH_CONE);
+}
+
+void ProceduralMeshes::DrawSphereMesh()
+{
+    DrawMesh(MESH_SPHERE);
+}
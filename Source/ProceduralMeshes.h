@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+// ProceduralMeshes.h
+// ============
+// generate the basic shape meshes on worker threads, cache the generated
+// geometry on disk, and upload it on the OpenGL context thread
+//
+// Shapes use the same extents and placement as the course ShapeMeshes: plane
+// spans -1..1 in XZ, box is a unit cube centered at the origin, cylinder and
+// cone have radius 1 with the base at y = 0 and the top at y = 1, sphere has
+// radius 1. Tessellation, vertex order and texture coordinates are this
+// generator's own and do not match ShapeMeshes vertex for vertex.
+// Vertex layout: position (location 0), normal (1), texture coords (2).
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderStats.h"
+#include <GL/glew.h>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+class ProceduralMeshes
+{
+public:
+    // constructor
+    ProceduralMeshes();
+    // destructor
+    ~ProceduralMeshes();
+
+    enum MESH_TYPE
+    {
+        MESH_PLANE,
+        MESH_BOX,
+        MESH_CYLINDER,
+        MESH_CONE,
+        MESH_SPHERE
+    };
+
+    // primitive type plus tessellation; identifies a mesh in memory and on disk
+    struct MESH_KEY
+    {
+        MESH_TYPE type = MESH_BOX;
+        int slices = 0;
+        int stacks = 0;
+
+        // ordering for the mesh maps; compares every field so no two
+        // tessellations can share an entry
+        bool operator<(const MESH_KEY& other) const
+        {
+            if (type != other.type) return type < other.type;
+            if (slices != other.slices) return slices < other.slices;
+            return stacks < other.stacks;
+        }
+    };
+
+    // CPU-side geometry filled by a worker thread
+    struct MESH_DATA
+    {
+        std::vector<float> vertices; // 8 floats per vertex
+        std::vector<GLuint> indices;
+        MESH_KEY key;
+        bool bFromCache = false;
+    };
+
+    // queue generation on a worker thread; repeated requests are ignored.
+    // slices/stacks of 0 use the default tessellation for the type
+    void RequestMesh(MESH_TYPE type, int slices = 0, int stacks = 0);
+
+    // wait for queued jobs and upload their buffers; call on the GL context thread
+    void UploadPendingMeshes();
+
+    // draw calls and VAO binds are added to these counters when set
+    void SetRenderStats(RENDER_STATS* pRenderStats);
+
+    void DrawMesh(MESH_TYPE type, int slices = 0, int stacks = 0);
+    void DrawPlaneMesh();
+    void DrawBoxMesh();
+    void DrawCylinderMesh();
+    void DrawConeMesh();
+    void DrawSphereMesh();
+
+private:
+    struct GL_MESH
+    {
+        MESH_KEY key;
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ebo = 0;
+        GLsizei indexCount = 0;
+    };
+
+    // keyed by MESH_KEY so drawing does no string work
+    std::map<MESH_KEY, GL_MESH> m_meshes;
+    std::map<MESH_KEY, std::future<MESH_DATA>> m_pending;
+    RENDER_STATS* m_pRenderStats;
+
+    static MESH_KEY ResolveKey(MESH_TYPE type, int slices, int stacks);
+    static std::string KeyName(const MESH_KEY& key);
+    static MESH_DATA BuildMesh(MESH_KEY key);
+};
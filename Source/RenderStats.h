@@ -0,0 +1,16 @@
+///////////////////////////////////////////////////////////////////////////////
+// RenderStats.h
+// ============
+// per-frame counters shared by the scene, mesh and texture code and reported
+// by the benchmark suite
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+struct RENDER_STATS
+{
+    // glDrawElements calls actually issued
+    int drawCalls = 0;
+    // shader uniform updates plus VAO and texture bind calls
+    int stateChanges = 0;
+};
@@ -30,9 +30,12 @@ static int screenHeight = 800;
 
 SceneManager::SceneManager(ShaderManager* pShaderManager)
     : m_pShaderManager(pShaderManager),
-    m_basicMeshes(new ShapeMeshes()),
+    m_basicMeshes(new ProceduralMeshes()),
+    m_pTextureResidency(new TextureResidencyManager()),
     m_loadedTextures(0)
 {
+    m_basicMeshes->SetRenderStats(&m_renderStats);
+    m_pTextureResidency->SetRenderStats(&m_renderStats);
 }
 
 SceneManager::~SceneManager()
@@ -41,6 +44,10 @@ SceneManager::~SceneManager()
         delete m_basicMeshes;
         m_basicMeshes = nullptr;
     }
+    if (m_pTextureResidency != nullptr) {
+        delete m_pTextureResidency;
+        m_pTextureResidency = nullptr;
+    }
     m_pShaderManager = nullptr;
 }
 
@@ -65,12 +72,16 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
         GLenum format = (colorChannels == 4) ? GL_RGBA : GL_RGB;
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, image);
         glGenerateMipmap(GL_TEXTURE_2D);
-
-        stbi_image_free(image);
         glBindTexture(GL_TEXTURE_2D, 0);
 
         m_textureIDs[m_loadedTextures].ID = textureID;
         m_textureIDs[m_loadedTextures].tag = tag;
+
+        // residency manager may immediately shrink this or older textures to fit the budget
+        m_pTextureResidency->RegisterTexture(m_loadedTextures, textureID, filename,
+            width, height, colorChannels, image);
+        stbi_image_free(image);
+
         m_loadedTextures++;
 
         return true;
@@ -85,6 +96,7 @@ void SceneManager::BindGLTextures()
     for (int i = 0; i < m_loadedTextures; i++) {
         glActiveTexture(GL_TEXTURE0 + i);
         glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+        m_renderStats.stateChanges += 2;
     }
 }
 
@@ -93,6 +105,7 @@ void SceneManager::DestroyGLTextures()
     for (int i = 0; i < m_loadedTextures; i++) {
         glDeleteTextures(1, &m_textureIDs[i].ID);
     }
+    m_pTextureResidency->UnregisterAll();
     m_loadedTextures = 0;
 }
 
@@ -142,55 +155,103 @@ void SceneManager::SetTransformations(
 
     glm::mat4 model = translation * rotationX * rotationY * rotationZ * scale;
     if (m_pShaderManager) {
-        m_pShaderManager->setMat4Value(g_ModelName, model);
+        SetUniform(g_ModelName, model);
     }
 }
 
 void SceneManager::SetShaderColor(float r, float g, float b, float a)
 {
     if (m_pShaderManager) {
-        m_pShaderManager->setIntValue(g_UseTextureName, false);
-        m_pShaderManager->setVec4Value(g_ColorValueName, glm::vec4(r, g, b, a));
+        SetUniform(g_UseTextureName, false);
+        SetUniform(g_ColorValueName, glm::vec4(r, g, b, a));
     }
 }
 
 void SceneManager::SetShaderTexture(std::string textureTag)
 {
     if (m_pShaderManager) {
-        m_pShaderManager->setIntValue(g_UseTextureName, true);
+        SetUniform(g_UseTextureName, true);
         int textureSlot = FindTextureSlot(textureTag);
-        m_pShaderManager->setSampler2DValue(g_TextureValueName, textureSlot);
+        SetSamplerUniform(g_TextureValueName, textureSlot);
+        m_pTextureResidency->MarkUsed(textureSlot);
     }
 }
 
+void SceneManager::SetTextureBudget(size_t budgetBytes)
+{
+    m_pTextureResidency->SetBudget(budgetBytes);
+}
+
 void SceneManager::SetTextureUVScale(float u, float v)
 {
     if (m_pShaderManager) {
-        m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
+        SetUniform("UVscale", glm::vec2(u, v));
     }
 }
 
+void SceneManager::SetUniform(const char* name, const glm::mat4& value)
+{
+    m_pShaderManager->setMat4Value(name, value);
+    m_renderStats.stateChanges++;
+}
+
+void SceneManager::SetUniform(const char* name, const glm::vec4& value)
+{
+    m_pShaderManager->setVec4Value(name, value);
+    m_renderStats.stateChanges++;
+}
+
+void SceneManager::SetUniform(const char* name, const glm::vec3& value)
+{
+    m_pShaderManager->setVec3Value(name, value);
+    m_renderStats.stateChanges++;
+}
+
+void SceneManager::SetUniform(const char* name, const glm::vec2& value)
+{
+    m_pShaderManager->setVec2Value(name, value);
+    m_renderStats.stateChanges++;
+}
+
+void SceneManager::SetUniform(const char* name, float value)
+{
+    m_pShaderManager->setFloatValue(name, value);
+    m_renderStats.stateChanges++;
+}
+
+void SceneManager::SetUniform(const char* name, int value)
+{
+    m_pShaderManager->setIntValue(name, value);
+    m_renderStats.stateChanges++;
+}
+
+void SceneManager::SetSamplerUniform(const char* name, int textureSlot)
+{
+    m_pShaderManager->setSampler2DValue(name, textureSlot);
+    m_renderStats.stateChanges++;
+}
+
 void SceneManager::SetShaderMaterial(std::string materialTag)
 {
     if (!m_pShaderManager) return;
     OBJECT_MATERIAL mat;
     if (FindMaterial(materialTag, mat)) {
-        m_pShaderManager->setFloatValue("material.ambientStrength", mat.ambientStrength);
-        m_pShaderManager->setVec3Value("material.ambientColor", mat.ambientColor);
-        m_pShaderManager->setVec3Value("material.diffuseColor", mat.diffuseColor);
-        m_pShaderManager->setVec3Value("material.specularColor", mat.specularColor);
-        m_pShaderManager->setFloatValue("material.shininess", mat.shininess);
+        SetUniform("material.ambientStrength", mat.ambientStrength);
+        SetUniform("material.ambientColor", mat.ambientColor);
+        SetUniform("material.diffuseColor", mat.diffuseColor);
+        SetUniform("material.specularColor", mat.specularColor);
+        SetUniform("material.shininess", mat.shininess);
     }
 }
 
 void SceneManager::PrepareScene()
 {
-    // Load meshes
-    m_basicMeshes->LoadPlaneMesh();
-    m_basicMeshes->LoadBoxMesh();
-    m_basicMeshes->LoadCylinderMesh();
-    m_basicMeshes->LoadConeMesh();
-    m_basicMeshes->LoadSphereMesh();
+    // Generate meshes on worker threads while textures load on this thread
+    m_basicMeshes->RequestMesh(ProceduralMeshes::MESH_PLANE);
+    m_basicMeshes->RequestMesh(ProceduralMeshes::MESH_BOX);
+    m_basicMeshes->RequestMesh(ProceduralMeshes::MESH_CYLINDER);
+    m_basicMeshes->RequestMesh(ProceduralMeshes::MESH_CONE);
+    m_basicMeshes->RequestMesh(ProceduralMeshes::MESH_SPHERE);
 
     // Load textures
     CreateGLTexture("../../Utilities/textures/pavers.jpg", "pavers");
@@ -201,6 +262,9 @@ void SceneManager::PrepareScene()
 
     BindGLTextures();
 
+    // Buffer uploads must happen on the GL context thread
+    m_basicMeshes->UploadPendingMeshes();
+
     // Define materials
     OBJECT_MATERIAL floorMat;
     floorMat.ambientStrength = 0.3f;
@@ -266,17 +330,17 @@ void SceneManager::RenderScene()
         projection = glm::ortho(-orthoSize * aspect, orthoSize * aspect, -orthoSize, orthoSize, 0.1f, 100.0f);
     }
 
-    m_pShaderManager->setMat4Value("projection", projection);
-    m_pShaderManager->setMat4Value("view", view);
+    SetUniform("projection", projection);
+    SetUniform("view", view);
 
     // Lighting (ambient + directional + point)
     glm::vec3 ambientLight(0.3f, 0.3f, 0.3f);
-    m_pShaderManager->setVec3Value("ambientLight", ambientLight);
+    SetUniform("ambientLight", ambientLight);
 
     glm::vec3 lightDir(-0.5f, -1.0f, -0.5f);
     glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
-    m_pShaderManager->setVec3Value("lightDirection", lightDir);
-    m_pShaderManager->setVec3Value("lightColor", lightColor);
+    SetUniform("lightDirection", lightDir);
+    SetUniform("lightColor", lightColor);
 
     // Background (drywall)
     SetTransformations(glm::vec3(100.0f), 0.0f, 0.0f, 0.0f, glm::vec3(0.0f));
@@ -321,6 +385,9 @@ void SceneManager::RenderScene()
     SetTextureUVScale(1.0f, 1.0f);
     m_basicMeshes->DrawConeMesh();
 
+    // Textures drawn this frame are now known; restore or evict to stay within budget
+    m_pTextureResidency->EndFrame();
+
     // Scene now:
     // - Camera perspective/orthographic toggle handled by g_bUsePerspective.
     // - Camera position/orientation updated externally; here we just use them.
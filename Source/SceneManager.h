@@ -10,7 +10,9 @@
 #pragma once
 
 #include "ShaderManager.h"
-#include "ShapeMeshes.h"
+#include "ProceduralMeshes.h"
+#include "TextureResidency.h"
+#include "RenderStats.h"
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
@@ -40,12 +42,21 @@ public:
         std::string tag{};
     };
 
+    // per-frame counters used by the benchmark suite
+    const RENDER_STATS& GetRenderStats() const { return m_renderStats; }
+    void ResetRenderStats() { m_renderStats = RENDER_STATS(); }
+
+    // limit GPU memory used by scene textures; 0 means unlimited
+    void SetTextureBudget(size_t budgetBytes);
+
 private:
     ShaderManager* m_pShaderManager;
-    ShapeMeshes* m_basicMeshes;
+    ProceduralMeshes* m_basicMeshes;
+    TextureResidencyManager* m_pTextureResidency;
     int m_loadedTextures;
     TEXTURE_INFO m_textureIDs[16];
     std::vector<OBJECT_MATERIAL> m_objectMaterials;
+    RENDER_STATS m_renderStats;
 
     bool CreateGLTexture(const char* filename, std::string tag);
     void BindGLTextures();
@@ -73,6 +84,17 @@ private:
 
     void SetShaderMaterial(std::string materialTag);
 
+    // every uniform update the scene makes goes through these so it is counted
+    // in m_renderStats; the benchmark renders through RenderScene alone, so its
+    // counts are complete
+    void SetUniform(const char* name, const glm::mat4& value);
+    void SetUniform(const char* name, const glm::vec4& value);
+    void SetUniform(const char* name, const glm::vec3& value);
+    void SetUniform(const char* name, const glm::vec2& value);
+    void SetUniform(const char* name, float value);
+    void SetUniform(const char* name, int value);
+    void SetSamplerUniform(const char* name, int textureSlot);
+
 public:
     void PrepareScene();
     void RenderScene();
@@ -0,0 +1,426 @@
+#include "TextureResidency.h"
+#include "stb_image.h"
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+
+namespace
+{
+    // a texture not drawn for this many frames may be evicted entirely
+    const unsigned long long g_RecentFrames = 120;
+    // decodes run on worker threads, but each one ends in a full upload on
+    // the GL thread, so start at most this many per frame
+    const int g_MaxRestoresPerFrame = 1;
+    // never drop mips below this size; smaller than that, evict instead
+    const int g_MinResidentSize = 32;
+    // drivers store RGB textures padded to RGBA
+    const size_t g_BytesPerTexel = 4;
+
+    size_t MipChainBytes(int width, int height)
+    {
+        size_t bytes = 0;
+        while (true) {
+            bytes += (size_t)width * (size_t)height * g_BytesPerTexel;
+            if (width == 1 && height == 1) break;
+            width = (width > 1) ? width / 2 : 1;
+            height = (height > 1) ? height / 2 : 1;
+        }
+        return bytes;
+    }
+
+    int MipLevelCount(int width, int height)
+    {
+        int levels = 1;
+        while (width > 1 || height > 1) {
+            width = (width > 1) ? width / 2 : 1;
+            height = (height > 1) ? height / 2 : 1;
+            levels++;
+        }
+        return levels;
+    }
+
+    int MipDimension(int size, int droppedMips)
+    {
+        size >>= droppedMips;
+        return (size > 0) ? size : 1;
+    }
+
+    // 2x2 box filter; the source is width x height with the given channel count
+    std::vector<unsigned char> HalveImage(const std::vector<unsigned char>& src,
+        int width, int height, int channels, int& outWidth, int& outHeight)
+    {
+        outWidth = (width > 1) ? width / 2 : 1;
+        outHeight = (height > 1) ? height / 2 : 1;
+        std::vector<unsigned char> dst((size_t)outWidth * outHeight * channels);
+
+        for (int y = 0; y < outHeight; y++) {
+            int y0 = (y * 2 < height) ? y * 2 : height - 1;
+            int y1 = (y * 2 + 1 < height) ? y * 2 + 1 : height - 1;
+            for (int x = 0; x < outWidth; x++) {
+                int x0 = (x * 2 < width) ? x * 2 : width - 1;
+                int x1 = (x * 2 + 1 < width) ? x * 2 + 1 : width - 1;
+                for (int c = 0; c < channels; c++) {
+                    int sum = src[((size_t)y0 * width + x0) * channels + c]
+                        + src[((size_t)y0 * width + x1) * channels + c]
+                        + src[((size_t)y1 * width + x0) * channels + c]
+                        + src[((size_t)y1 * width + x1) * channels + c];
+                    dst[((size_t)y * outWidth + x) * channels + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        return dst;
+    }
+}
+
+TextureResidencyManager::TextureResidencyManager()
+    : m_budgetBytes(0),
+    m_residentBytes(0),
+    m_frame(0),
+    m_bOverBudgetReported(false),
+    m_pRenderStats(nullptr)
+{
+}
+
+TextureResidencyManager::~TextureResidencyManager()
+{
+    UnregisterAll();
+}
+
+void TextureResidencyManager::SetBudget(size_t budgetBytes)
+{
+    m_budgetBytes = budgetBytes;
+    std::cout << "[TextureResidency] Budget set to " << (m_budgetBytes / (1024 * 1024)) << " MB" << std::endl;
+    EnforceBudget();
+}
+
+size_t TextureResidencyManager::GetResidentBytes() const
+{
+    return m_residentBytes;
+}
+
+void TextureResidencyManager::RegisterTexture(int slot, GLuint textureID, const char* filename,
+    int width, int height, int colorChannels, const unsigned char* image)
+{
+    TEXTURE_RESIDENCY tex;
+    tex.slot = slot;
+    tex.ID = textureID;
+    tex.filename = filename;
+    tex.width = width;
+    tex.height = height;
+    tex.colorChannels = colorChannels;
+    tex.bytes = MipChainBytes(width, height);
+    tex.lastUsedFrame = m_frame;
+
+    // average color stands in for the texture while it is evicted
+    unsigned long long sums[4] = { 0, 0, 0, 0 };
+    size_t texels = (size_t)width * (size_t)height;
+    for (size_t i = 0; i < texels; i++) {
+        for (int c = 0; c < colorChannels && c < 4; c++) {
+            sums[c] += image[i * colorChannels + c];
+        }
+    }
+    for (int c = 0; c < colorChannels && c < 4; c++) {
+        tex.placeholder[c] = (unsigned char)(sums[c] / (texels ? texels : 1));
+    }
+
+    m_residentBytes += tex.bytes;
+    m_textures.push_back(std::move(tex));
+
+    // keep loading within budget instead of waiting for the first frame
+    EnforceBudget();
+}
+
+void TextureResidencyManager::UnregisterAll()
+{
+    m_textures.clear();
+    m_residentBytes = 0;
+}
+
+void TextureResidencyManager::SetRenderStats(RENDER_STATS* pRenderStats)
+{
+    m_pRenderStats = pRenderStats;
+}
+
+void TextureResidencyManager::MarkUsed(int slot)
+{
+    TEXTURE_RESIDENCY* tex = FindTexture(slot);
+    if (tex) {
+        tex->lastUsedFrame = m_frame;
+    }
+}
+
+void TextureResidencyManager::EndFrame()
+{
+    if (m_budgetBytes > 0) {
+        FinishRestores();
+        RestoreVisible();
+        EnforceBudget();
+    }
+    m_frame++;
+}
+
+TextureResidencyManager::TEXTURE_RESIDENCY* TextureResidencyManager::FindTexture(int slot)
+{
+    for (auto& tex : m_textures) {
+        if (tex.slot == slot) {
+            return &tex;
+        }
+    }
+    return nullptr;
+}
+
+bool TextureResidencyManager::IsStale(const TEXTURE_RESIDENCY& tex) const
+{
+    return m_frame - tex.lastUsedFrame > g_RecentFrames;
+}
+
+int TextureResidencyManager::MaxDroppedMips(const TEXTURE_RESIDENCY& tex) const
+{
+    int dropped = 0;
+    while (MipDimension(tex.width, dropped + 1) >= g_MinResidentSize &&
+        MipDimension(tex.height, dropped + 1) >= g_MinResidentSize) {
+        dropped++;
+    }
+    return dropped;
+}
+
+void TextureResidencyManager::BindForUpload(const TEXTURE_RESIDENCY& tex)
+{
+    glActiveTexture(GL_TEXTURE0 + tex.slot);
+    glBindTexture(GL_TEXTURE_2D, tex.ID);
+    if (m_pRenderStats) {
+        m_pRenderStats->stateChanges += 2; // active unit and texture binding
+    }
+}
+
+void TextureResidencyManager::ReleaseLevelsFrom(const TEXTURE_RESIDENCY& tex, int firstLevel)
+{
+    // a smaller base level leaves the deeper levels of the previous, larger
+    // chain defined and allocated; redefine them as empty so the driver frees
+    // them and m_residentBytes matches what is really on the GPU.
+    // expects the texture to be bound
+    GLenum format = (tex.colorChannels == 4) ? GL_RGBA : GL_RGB;
+    int fullLevels = MipLevelCount(tex.width, tex.height);
+    for (int level = firstLevel; level < fullLevels; level++) {
+        glTexImage2D(GL_TEXTURE_2D, level, format, 0, 0, 0, format, GL_UNSIGNED_BYTE, nullptr);
+    }
+}
+
+void TextureResidencyManager::Respecify(TEXTURE_RESIDENCY& tex, int droppedMips,
+    int width, int height, int colorChannels, const void* pixels, GLuint pixelBuffer)
+{
+    // respecify in place so the texture name and its unit binding stay valid
+    BindForUpload(tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GLenum format = (colorChannels == 4) ? GL_RGBA : GL_RGB;
+    if (pixelBuffer) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    if (pixelBuffer) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    ReleaseLevelsFrom(tex, MipLevelCount(width, height));
+
+    m_residentBytes -= tex.bytes;
+    tex.bytes = MipChainBytes(width, height);
+    m_residentBytes += tex.bytes;
+    tex.droppedMips = droppedMips;
+    tex.bEvicted = false;
+
+    std::cout << "[TextureResidency] " << tex.filename << " resident at " << width << "x" << height
+        << " (" << (m_residentBytes / 1024) << " KB in use)" << std::endl;
+}
+
+TextureResidencyManager::DECODED_IMAGE TextureResidencyManager::DecodeSource(std::string filename, int droppedMips)
+{
+    // the vertical flip flag is global in stb_image; SceneManager sets it
+    // before loading any texture, so it is not touched from worker threads
+    DECODED_IMAGE decoded;
+    decoded.droppedMips = droppedMips;
+    unsigned char* image = stbi_load(filename.c_str(),
+        &decoded.width, &decoded.height, &decoded.colorChannels, 0);
+    if (!image) return decoded;
+
+    decoded.pixels.assign(image, image + (size_t)decoded.width * decoded.height * decoded.colorChannels);
+    stbi_image_free(image);
+
+    for (int i = 0; i < droppedMips; i++) {
+        int halfWidth = 0, halfHeight = 0;
+        decoded.pixels = HalveImage(decoded.pixels, decoded.width, decoded.height,
+            decoded.colorChannels, halfWidth, halfHeight);
+        decoded.width = halfWidth;
+        decoded.height = halfHeight;
+    }
+    decoded.bLoaded = true;
+    return decoded;
+}
+
+void TextureResidencyManager::StartRestore(TEXTURE_RESIDENCY& tex, int droppedMips)
+{
+    tex.restoreDroppedMips = droppedMips;
+    tex.restore = std::async(std::launch::async, &TextureResidencyManager::DecodeSource,
+        tex.filename, droppedMips);
+}
+
+void TextureResidencyManager::FinishRestores()
+{
+    for (auto& tex : m_textures) {
+        if (!tex.restore.valid()) continue;
+        if (tex.restore.wait_for(std::chrono::seconds(0)) != std::future_status::ready) continue;
+
+        DECODED_IMAGE decoded;
+        try {
+            decoded = tex.restore.get();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[TextureResidency] Could not reload image: " << tex.filename
+                << " (" << e.what() << ")" << std::endl;
+            continue;
+        }
+        if (!decoded.bLoaded) {
+            std::cerr << "[TextureResidency] Could not reload image: " << tex.filename << std::endl;
+            continue;
+        }
+
+        Respecify(tex, decoded.droppedMips, decoded.width, decoded.height,
+            decoded.colorChannels, decoded.pixels.data());
+    }
+}
+
+size_t TextureResidencyManager::PendingRestoreBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& tex : m_textures) {
+        if (!tex.restore.valid()) continue;
+        size_t restored = MipChainBytes(MipDimension(tex.width, tex.restoreDroppedMips),
+            MipDimension(tex.height, tex.restoreDroppedMips));
+        if (restored > tex.bytes) bytes += restored - tex.bytes;
+    }
+    return bytes;
+}
+
+void TextureResidencyManager::DropMips(TEXTURE_RESIDENCY& tex, int droppedMips)
+{
+    // the smaller level is already on the GPU as part of the current mip
+    // chain. Copy it into a pixel buffer and respecify from there, so the
+    // data never comes back to the CPU and nothing waits on the GPU
+    int level = droppedMips - tex.droppedMips;
+    int width = MipDimension(tex.width, droppedMips);
+    int height = MipDimension(tex.height, droppedMips);
+    GLenum format = (tex.colorChannels == 4) ? GL_RGBA : GL_RGB;
+    int channels = (tex.colorChannels == 4) ? 4 : 3;
+
+    GLuint pixelBuffer = 0;
+    glGenBuffers(1, &pixelBuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * channels, nullptr, GL_STREAM_COPY);
+    BindForUpload(tex);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, level, format, GL_UNSIGNED_BYTE, nullptr);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    Respecify(tex, droppedMips, width, height, channels, nullptr, pixelBuffer);
+
+    // the driver keeps the storage alive until the queued copies have run
+    glDeleteBuffers(1, &pixelBuffer);
+}
+
+void TextureResidencyManager::Evict(TEXTURE_RESIDENCY& tex)
+{
+    BindForUpload(tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, tex.placeholder);
+    ReleaseLevelsFrom(tex, 1);
+
+    m_residentBytes -= tex.bytes;
+    tex.bytes = MipChainBytes(1, 1);
+    m_residentBytes += tex.bytes;
+    tex.bEvicted = true;
+
+    std::cout << "[TextureResidency] Evicted " << tex.filename
+        << " (" << (m_residentBytes / 1024) << " KB in use)" << std::endl;
+}
+
+void TextureResidencyManager::RestoreVisible()
+{
+    // memory that EnforceBudget() is allowed to reclaim without touching
+    // anything drawn recently
+    size_t reclaimable = 0;
+    for (const auto& tex : m_textures) {
+        if (!tex.bEvicted && IsStale(tex)) {
+            reclaimable += tex.bytes - MipChainBytes(1, 1);
+        }
+    }
+
+    size_t pending = PendingRestoreBytes();
+    int restores = 0;
+    for (auto& tex : m_textures) {
+        if (restores >= g_MaxRestoresPerFrame) break;
+        if (tex.lastUsedFrame != m_frame) continue;
+        if (tex.restore.valid()) continue;
+        if (!tex.bEvicted && tex.droppedMips == 0) continue;
+
+        // best quality that fits once stale textures are evicted and the
+        // restores already in flight land, so the restore is not immediately
+        // undone by EnforceBudget()
+        size_t available = m_budgetBytes + reclaimable + tex.bytes;
+        int current = tex.bEvicted ? MaxDroppedMips(tex) + 1 : tex.droppedMips;
+        for (int dropped = 0; dropped < current; dropped++) {
+            size_t needed = MipChainBytes(MipDimension(tex.width, dropped), MipDimension(tex.height, dropped));
+            if (m_residentBytes + pending + needed <= available) {
+                StartRestore(tex, dropped);
+                pending += needed - tex.bytes;
+                restores++;
+                break;
+            }
+        }
+    }
+}
+
+void TextureResidencyManager::EnforceBudget()
+{
+    if (m_budgetBytes == 0) return;
+
+    while (m_residentBytes > m_budgetBytes) {
+        // least recently used texture that still has something to give up:
+        // stale textures are evicted, recently visible ones lose mip levels
+        TEXTURE_RESIDENCY* victim = nullptr;
+        for (auto& tex : m_textures) {
+            if (tex.bEvicted) continue;
+            if (tex.restore.valid()) continue; // shrinking it now would be undone on upload
+            if (!IsStale(tex) && tex.droppedMips >= MaxDroppedMips(tex)) continue;
+            // on ties (e.g. everything loaded in the same frame) shrink the
+            // largest first so quality loss is spread across textures
+            if (!victim || tex.lastUsedFrame < victim->lastUsedFrame ||
+                (tex.lastUsedFrame == victim->lastUsedFrame && tex.bytes > victim->bytes)) {
+                victim = &tex;
+            }
+        }
+
+        if (!victim) {
+            // runs every frame, so only report when the scene first goes over
+            if (!m_bOverBudgetReported) {
+                std::cerr << "[TextureResidency] Visible textures need " << (m_residentBytes / 1024)
+                    << " KB, over the " << (m_budgetBytes / 1024) << " KB budget" << std::endl;
+                m_bOverBudgetReported = true;
+            }
+            return;
+        }
+
+        if (IsStale(*victim)) {
+            Evict(*victim);
+            continue;
+        }
+
+        // drop just enough levels to cover the overage, in a single upload
+        size_t excess = m_residentBytes - m_budgetBytes;
+        int maxDropped = MaxDroppedMips(*victim);
+        int target = victim->droppedMips + 1;
+        while (target < maxDropped &&
+            victim->bytes - MipChainBytes(MipDimension(victim->width, target), MipDimension(victim->height, target)) < excess) {
+            target++;
+        }
+        DropMips(*victim, target);
+    }
+    m_bOverBudgetReported = false;
+}
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureResidency.h
+// ============
+// track the GPU memory used by scene textures and keep it under a budget by
+// dropping top mip levels or evicting textures that have not been visible
+// recently; higher resolutions are decoded from the source images on worker
+// threads and uploaded on the OpenGL context thread once ready
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderStats.h"
+#include <GL/glew.h>
+#include <cstddef>
+#include <future>
+#include <string>
+#include <vector>
+
+class TextureResidencyManager
+{
+public:
+    // constructor
+    TextureResidencyManager();
+    // destructor
+    ~TextureResidencyManager();
+
+    // budget in bytes; 0 means unlimited
+    void SetBudget(size_t budgetBytes);
+    size_t GetResidentBytes() const;
+
+    // start tracking a texture that was just uploaded at full resolution
+    void RegisterTexture(int slot, GLuint textureID, const char* filename,
+        int width, int height, int colorChannels, const unsigned char* image);
+    void UnregisterAll();
+
+    // texture binds made while uploading are added to these counters when set
+    void SetRenderStats(RENDER_STATS* pRenderStats);
+
+    // the texture bound to this slot is used by an object drawn this frame
+    void MarkUsed(int slot);
+
+    // restore textures that became visible again and enforce the budget
+    void EndFrame();
+
+private:
+    // source image scaled down on a worker thread, ready to upload
+    struct DECODED_IMAGE
+    {
+        std::vector<unsigned char> pixels;
+        int width = 0;
+        int height = 0;
+        int colorChannels = 0;
+        int droppedMips = 0;
+        bool bLoaded = false;
+    };
+
+    struct TEXTURE_RESIDENCY
+    {
+        int slot = -1;
+        GLuint ID = 0;
+        std::string filename{};
+        int width = 0;
+        int height = 0;
+        int colorChannels = 0;
+        unsigned char placeholder[4] = { 0, 0, 0, 255 }; // average color, used while evicted
+        int droppedMips = 0;   // top mip levels not resident
+        bool bEvicted = false;
+        size_t bytes = 0;
+        unsigned long long lastUsedFrame = 0;
+        std::future<DECODED_IMAGE> restore; // valid while a decode is in flight
+        int restoreDroppedMips = 0;         // level the decode in flight produces
+    };
+
+    std::vector<TEXTURE_RESIDENCY> m_textures;
+    size_t m_budgetBytes;
+    size_t m_residentBytes;
+    unsigned long long m_frame;
+    bool m_bOverBudgetReported; // warn once per stretch of frames over budget
+    RENDER_STATS* m_pRenderStats;
+
+    void BindForUpload(const TEXTURE_RESIDENCY& tex);
+    // free levels at and below firstLevel left over from a larger mip chain
+    void ReleaseLevelsFrom(const TEXTURE_RESIDENCY& tex, int firstLevel);
+
+    TEXTURE_RESIDENCY* FindTexture(int slot);
+    bool IsStale(const TEXTURE_RESIDENCY& tex) const;
+    int MaxDroppedMips(const TEXTURE_RESIDENCY& tex) const;
+
+    // pixels is an offset into pixelBuffer when that is non-zero
+    void Respecify(TEXTURE_RESIDENCY& tex, int droppedMips,
+        int width, int height, int colorChannels, const void* pixels, GLuint pixelBuffer = 0);
+    // decode the source image; only needed to raise resolution. Runs on a
+    // worker thread and must not touch OpenGL
+    static DECODED_IMAGE DecodeSource(std::string filename, int droppedMips);
+    void StartRestore(TEXTURE_RESIDENCY& tex, int droppedMips);
+    // upload decodes that have finished; never waits for one
+    void FinishRestores();
+    // extra bytes the restores in flight will need once uploaded
+    size_t PendingRestoreBytes() const;
+    // lower resolution from the mip chain already on the GPU
+    void DropMips(TEXTURE_RESIDENCY& tex, int droppedMips);
+    void Evict(TEXTURE_RESIDENCY& tex);
+    void RestoreVisible();
+    void EnforceBudget();
+};